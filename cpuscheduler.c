@@ -18,6 +18,11 @@
 #define LARGEST_SMALL_PROC 125	
 #define SMALLEST_LARGE_PROC 151
 #define LARGEST_LARGE_PROC 250
+#define JOB_POOL_IMAGE "job_pool.img"
+#define JOB_POOL_MAGIC "CSJPOOL"
+#define JOB_POOL_VERSION 1
+#define JOB_POOL_ALIGN 64
+#define JOB_POOL_SEED 1
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +31,9 @@
 
 #ifdef __unix__
     # include <unistd.h>
+    # include <fcntl.h>
+    # include <sys/mman.h>
+    # include <sys/stat.h>
 #elif defined _WIN32
     # include <windows.h>
     #define sleep(x) Sleep(x)
@@ -47,6 +55,44 @@ typedef struct Queue
         int *elements;
 } Queue;
 
+/* A job pool image is a binary file holding a header followed by the job
+ * quanta, so it can be mapped and used directly without any parsing.
+ *  - magic and version identify the file format.
+ *  - header_size, elem_size and jobs_offset describe the layout; the jobs
+ *    array starts at jobs_offset, which is aligned to JOB_POOL_ALIGN.
+ *  - num_jobs through largest_large are the generator parameters and seed
+ *    used to produce the jobs. An image whose parameters do not match the
+ *    compiled-in ones is regenerated.
+ */
+typedef struct JobPoolHeader
+{
+        char magic[8];
+        int version;
+        int header_size;
+        int elem_size;
+        int jobs_offset;
+        int num_jobs;
+        int percent_long;
+        int smallest_small;
+        int largest_small;
+        int smallest_large;
+        int largest_large;
+        unsigned int seed;
+} JobPoolHeader;
+
+/* A JobPool is a read-only view of a job pool image.
+ *  - base and length describe the mapped (or loaded) image.
+ *  - header points at the image header.
+ *  - jobs points at the first job quanta in the image.
+ */
+typedef struct JobPool
+{
+        void *base;
+        size_t length;
+        const JobPoolHeader *header;
+        const int *jobs;
+} JobPool;
+
 // Function Prototypes
 void FCFS(Queue *ready, Queue *pool);
 int front(Queue *Q);
@@ -54,7 +100,12 @@ void enqueue(Queue *Q, int element);
 void dequeue(Queue *Q);
 Queue* createQueue(int maxElements);
 void transfer(Queue *Q, Queue *R, int amt);
-void createJobPool();
+void createJobPool(unsigned int seed);
+int isJobPoolValid(const JobPoolHeader *header, size_t length, unsigned int seed);
+JobPool* mapJobPool(unsigned int seed);
+JobPool* openJobPool(unsigned int seed);
+void unmapJobPool(JobPool *pool);
+Queue* createPoolView(JobPool *pool);
 void RoundRobin(Queue *ready, Queue *pool);
 void ModifiedRoundRobin(Queue *ready, Queue *pool);
 void ModifiedHalfedRoundRobin(Queue *ready, Queue *pool);
@@ -66,35 +117,29 @@ int main(){
 	Queue *ready_queue;
 	Queue *FCFS_queue, *RR_queue, *MRR_queue, *MHRR_queue;
 	Queue *FCFS_pool, *RR_pool, *MRR_pool, *MHRR_pool;
+	JobPool *job_pool;
 	ready_queue = createQueue(MAX_SIZE_QUEUE);
 
-	createJobPool();
-	int i = 0;
-	FILE *f;
-	f = fopen("job_pool.txt", "r");
+	// Map the cached job pool image, generating it only if it is missing
+	// or was built with different parameters.
+	printf("%s\n", "Loading jobs.");
+	job_pool = mapJobPool(JOB_POOL_SEED);
+	if (job_pool == NULL){
+		printf("Unable to load the job pool image %s\n", JOB_POOL_IMAGE);
+		return 1;
+	}
 
-	// Copy the job pool data into another queue for each scheduling
-    	// method and copy the queue of elements into another queue for
-    	// each scheduling method
-	printf("%s\n", "Generating jobs.");
-    	FCFS_pool = createQueue(JOB_POOL_SIZE);
-    	RR_pool = createQueue(JOB_POOL_SIZE);
-    	MRR_pool = createQueue(JOB_POOL_SIZE);
-    	MHRR_pool = createQueue(JOB_POOL_SIZE);
+	// Every scheduling method gets its own view of the same job pool data,
+	// so each one consumes the jobs in the same order without copying them.
+    	FCFS_pool = createPoolView(job_pool);
+    	RR_pool = createPoolView(job_pool);
+    	MRR_pool = createPoolView(job_pool);
+    	MHRR_pool = createPoolView(job_pool);
 
     	FCFS_queue = createQueue(MAX_SIZE_QUEUE);
     	RR_queue = createQueue(MAX_SIZE_QUEUE);
     	MRR_queue = createQueue(MAX_SIZE_QUEUE);
     	MHRR_queue = createQueue(MAX_SIZE_QUEUE);
-
-    	for (i = 0; i < JOB_POOL_SIZE; i++){
-    	    int quanta;
-    	    fscanf(f, "%i", &quanta);
-    	    enqueue(FCFS_pool, quanta);
-    	    enqueue(RR_pool, quanta);
-    	    enqueue(MRR_pool, quanta);
-    	    enqueue(MHRR_pool, quanta);
-    	}
 	
     	// Transfer jobs to reach the steady state.
 	printf("%s\n", "Transferring elements to reach the steady state.");
@@ -116,7 +161,8 @@ int main(){
     	ModifiedHalfedRoundRobin(MHRR_queue, MHRR_pool);
 
 	printf("%s\n", "Freeing allocated memory.");
-	// Free all allocated memory
+	// Free all allocated memory. The pool views do not own their elements,
+	// those belong to the job pool image.
 	free(ready_queue);
 	free(FCFS_queue);
 	free(RR_queue);
@@ -126,20 +172,43 @@ int main(){
 	free(RR_pool);
 	free(MRR_pool);
 	free(MHRR_pool);
+	unmapJobPool(job_pool);
 	
 	return 0;
 }
 
-// Fill the job pool with available jobs for the CPU to "work" on.
-void createJobPool(){
+// Fill the job pool image with available jobs for the CPU to "work" on. The
+// jobs are generated from the given seed and written after the header at an
+// aligned offset. The image is written to a temporary file first and then
+// renamed, so other processes never see a partially written image.
+void createJobPool(unsigned int seed){
     int lcv;
     FILE *file;
-    file = fopen("job_pool.txt", "w+");
+    JobPoolHeader header;
+    char padding[JOB_POOL_ALIGN] = {0};
+    char temp_name[64];
+    int *jobs = (int*) malloc (sizeof(int) * JOB_POOL_SIZE);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JOB_POOL_MAGIC, sizeof(JOB_POOL_MAGIC));
+    header.version = JOB_POOL_VERSION;
+    header.header_size = sizeof(JobPoolHeader);
+    header.elem_size = sizeof(int);
+    header.jobs_offset = (sizeof(JobPoolHeader) + JOB_POOL_ALIGN - 1) / JOB_POOL_ALIGN * JOB_POOL_ALIGN;
+    header.num_jobs = JOB_POOL_SIZE;
+    header.percent_long = PERCENT_LONG;
+    header.smallest_small = SMALLEST_SMALL_PROC;
+    header.largest_small = LARGEST_SMALL_PROC;
+    header.smallest_large = SMALLEST_LARGE_PROC;
+    header.largest_large = LARGEST_LARGE_PROC;
+    header.seed = seed;
+
+    srand(seed);
 
     for (lcv = 0; lcv < JOB_POOL_SIZE; lcv++){
 
         int longorshort = rand() % 100;
-        int max, min, quanta;
+        int max, min;
 
         if (longorshort > PERCENT_LONG){
             max = LARGEST_SMALL_PROC;
@@ -149,11 +218,165 @@ void createJobPool(){
             min = SMALLEST_LARGE_PROC;
         }
 
-	quanta = (double) rand() / (RAND_MAX+1.0) * (max-min) + min;
-        fprintf(file, "%i\n", quanta);
+	jobs[lcv] = (double) rand() / (RAND_MAX+1.0) * (max-min) + min;
 	}
 
+#ifdef __unix__
+    snprintf(temp_name, sizeof(temp_name), "%s.%ld", JOB_POOL_IMAGE, (long) getpid());
+#else
+    snprintf(temp_name, sizeof(temp_name), "%s.tmp", JOB_POOL_IMAGE);
+#endif
+
+    file = fopen(temp_name, "wb");
+    if (file == NULL){
+        free(jobs);
+        return;
+    }
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(padding, 1, header.jobs_offset - sizeof(header), file);
+    fwrite(jobs, sizeof(int), JOB_POOL_SIZE, file);
 	fclose(file);
+	free(jobs);
+
+#ifndef __unix__
+	remove(JOB_POOL_IMAGE);
+#endif
+	rename(temp_name, JOB_POOL_IMAGE);
+}
+
+// Check that a job pool image of the given length has a header matching the
+// current file format and generator parameters, and that it is large enough
+// to hold all of its jobs. Returns 1 if the image can be used, 0 otherwise.
+int isJobPoolValid(const JobPoolHeader *header, size_t length, unsigned int seed){
+    if (length < sizeof(JobPoolHeader)){
+        return 0;
+    }
+
+    return memcmp(header->magic, JOB_POOL_MAGIC, sizeof(JOB_POOL_MAGIC)) == 0
+        && header->version == JOB_POOL_VERSION
+        && header->header_size == sizeof(JobPoolHeader)
+        && header->elem_size == sizeof(int)
+        && header->jobs_offset >= (int) sizeof(JobPoolHeader)
+        && header->jobs_offset % JOB_POOL_ALIGN == 0
+        && header->num_jobs == JOB_POOL_SIZE
+        && header->percent_long == PERCENT_LONG
+        && header->smallest_small == SMALLEST_SMALL_PROC
+        && header->largest_small == LARGEST_SMALL_PROC
+        && header->smallest_large == SMALLEST_LARGE_PROC
+        && header->largest_large == LARGEST_LARGE_PROC
+        && header->seed == seed
+        && length >= (size_t) header->jobs_offset + sizeof(int) * header->num_jobs;
+}
+
+// Map the job pool image read-only. If the image does not exist or was built
+// from different parameters it is regenerated once. A pointer to the job pool
+// is returned, or NULL if no usable image could be loaded.
+JobPool* mapJobPool(unsigned int seed){
+    JobPool *pool = openJobPool(seed);
+
+    if (pool == NULL){
+        createJobPool(seed);
+        pool = openJobPool(seed);
+    }
+
+    return pool;
+}
+
+// Open an existing job pool image. On unix the image is memory-mapped and
+// shared between every process that uses it, elsewhere it is read into
+// memory in a single call. Returns NULL if the image is missing or invalid.
+JobPool* openJobPool(unsigned int seed){
+    JobPool *pool;
+    void *base;
+    size_t length;
+
+#ifdef __unix__
+    struct stat st;
+    int fd = open(JOB_POOL_IMAGE, O_RDONLY);
+
+    if (fd < 0){
+        return NULL;
+    }
+
+    if (fstat(fd, &st) < 0 || st.st_size <= 0){
+        close(fd);
+        return NULL;
+    }
+
+    length = st.st_size;
+    base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED){
+        return NULL;
+    }
+#else
+    FILE *file = fopen(JOB_POOL_IMAGE, "rb");
+    long size;
+
+    if (file == NULL){
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size <= 0){
+        fclose(file);
+        return NULL;
+    }
+
+    length = size;
+    base = malloc(length);
+    if (base == NULL || fread(base, 1, length, file) != length){
+        free(base);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+#endif
+
+    pool = (JobPool *)malloc(sizeof(JobPool));
+    pool->base = base;
+    pool->length = length;
+    pool->header = (const JobPoolHeader *) base;
+
+    if (!isJobPoolValid(pool->header, length, seed)){
+        unmapJobPool(pool);
+        return NULL;
+    }
+
+    pool->jobs = (const int *) ((const char *) base + pool->header->jobs_offset);
+
+    return pool;
+}
+
+// Release a job pool returned by mapJobPool.
+void unmapJobPool(JobPool *pool){
+#ifdef __unix__
+    munmap(pool->base, pool->length);
+#else
+    free(pool->base);
+#endif
+    free(pool);
+}
+
+// Create a queue that reads its jobs straight out of the job pool image. The
+// queue starts full and is only ever drained with front and dequeue, so the
+// read-only elements are never written to. Free it with free() only; the
+// elements belong to the job pool.
+Queue* createPoolView(JobPool *pool){
+        Queue *Q;
+        Q = (Queue *)malloc(sizeof(Queue));
+        Q->elements = (int *) pool->jobs;
+        Q->size = pool->header->num_jobs;
+        Q->capacity = pool->header->num_jobs;
+        Q->front = 0;
+        Q->rear = pool->header->num_jobs - 1;
+
+        return Q;
 }
 
 // Move jobs from the ready_pool to the read_queue